@@ -39,7 +39,7 @@
    We explicitly reserve the right to change the connection
    implementation without a compatibility layer.
  */
-#define R_CONNECTIONS_VERSION 1
+#define R_CONNECTIONS_VERSION 2
 
 /* this allows the opaque pointer definition to be made available 
    in Rinternals.h */
@@ -79,6 +79,11 @@ struct Rconn {
     void *ex_ptr;
     void *private;
     int status; /* for pipes etc */
+    /* version 2: reads with re-encoding go through Riconv_bulk() into
+       'bulkbuff' instead of 'iconvbuff' */
+    void *inbulk; /* from Riconv_open_bulk(); NULL if not in use */
+    char *bulkbuff;
+    size_t bulksize, bulkpos, bulkavail;
 };
 
 #ifdef  __cplusplus
@@ -174,4 +174,42 @@
 				  i, i1, i2, i3, i4, i5, loop_body);	\
     } while (0)
 
+/* Iterate over the elements strt to strt + nfull - 1 of vector 'sx'
+   a block at a time.  In 'expr', 'px' points to 'nb' elements of
+   type 'etype' starting at index 'idx'.  If the data of 'sx' is
+   available this is a single block; otherwise (e.g. for compact
+   sequences) blocks of up to GET_REGION_BUFSIZE elements are copied
+   with vtype##_GET_REGION.  'vtype' is one of INTEGER, REAL, LOGICAL,
+   RAW or COMPLEX. */
+#define GET_REGION_BUFSIZE 512
+
+#define ITERATE_BY_REGION_PARTIAL(sx, px, idx, nb, etype, vtype,	\
+				  strt, nfull, expr) do {		\
+	const etype *__ibr_data__ = (const etype *) DATAPTR_OR_NULL(sx); \
+	R_xlen_t __ibr_end__ = (strt) + (nfull);			\
+	if (__ibr_data__ != NULL) {					\
+	    const etype *px = __ibr_data__ + (strt);			\
+	    for (R_xlen_t idx = (strt), nb = (nfull); idx < __ibr_end__; \
+		 idx += nb) {						\
+		expr							\
+	    }								\
+	}								\
+	else {								\
+	    etype __ibr_buf__[GET_REGION_BUFSIZE];			\
+	    const etype *px = __ibr_buf__;				\
+	    R_xlen_t nb;						\
+	    for (R_xlen_t idx = (strt); idx < __ibr_end__; idx += nb) { \
+		nb = vtype##_GET_REGION(sx, idx,			\
+					__ibr_end__ - idx < GET_REGION_BUFSIZE ? \
+					__ibr_end__ - idx : GET_REGION_BUFSIZE, \
+					__ibr_buf__);			\
+		expr							\
+	    }								\
+	}								\
+    } while (0)
+
+#define ITERATE_BY_REGION(sx, px, idx, nb, etype, vtype, expr)		\
+    ITERATE_BY_REGION_PARTIAL(sx, px, idx, nb, etype, vtype,		\
+			      0, XLENGTH(sx), expr)
+
 #endif /* R_EXT_ITERMACROS_H_ */
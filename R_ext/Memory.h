@@ -44,11 +44,99 @@ void	vmaxset(const void * ovmax);
 void	R_gc(void);
 int	R_gc_running();
 
+/* Parallel marking (memory.c).  With n > 1 the mark phase of each
+   collection runs on up to n threads using work-stealing mark
+   stacks; generations, node classes and finalizers behave as with a
+   single thread.  n = 1 marks on the calling thread only, n = 0
+   restores the default, R_num_math_threads (R_ext/MathThreads.h),
+   and n < 0 just queries.  Returns the previous setting. */
+int	R_gc_mark_threads(int n);
+
+/* Out-of-line mark bits (memory.c).  With on != 0 the collector keeps
+   mark bits in a bitmap per heap page instead of in the object
+   headers, so marking writes to no object page.  The sweep still
+   rewrites the generation links and gcgen of the nodes it frees or
+   promotes, so a collection of level L dirties only pages holding
+   nodes of generations 0 to L; older generations are left alone.
+   Forked workers should turn this on before their first collection
+   (mcfork() does): objects inherited from the parent are normally in
+   the oldest generation, so their pages stay shared with the parent
+   until a full (level 2) collection.  Switching takes effect at the
+   next collection.  on < 0 just queries; returns the previous
+   setting. */
+int	R_gc_mark_bitmap(int on);
+
+/* GC telemetry (memory.c) */
+typedef enum {
+    R_GC_TRIGGER_NODES,		/* cons cell limit reached */
+    R_GC_TRIGGER_VECTORS,	/* vector heap limit reached */
+    R_GC_TRIGGER_EXPLICIT,	/* R_gc() or gc() */
+    R_GC_TRIGGER_TORTURE,	/* gctorture() */
+    R_GC_TRIGGER_HEAP_LIMIT	/* adaptive heap policy near the memory limit */
+} R_gc_trigger_t;
+
+typedef struct {
+    size_t count;		/* number of this collection since startup */
+    int level;			/* generations collected: 0, 1 or 2 */
+    R_gc_trigger_t trigger;
+    double pause;		/* elapsed seconds; 0 at GC start */
+    size_t bytes_freed;		/* 0 at GC start, as are the rest */
+    size_t nodes_promoted;
+    size_t large_vec_bytes;	/* in large vectors after the collection */
+} R_gc_info_t;
+
+#define R_GC_START 0
+#define R_GC_END   1
+
+/* Called with phase R_GC_START before and R_GC_END after every
+   collection, on the thread running it.  Callbacks must not allocate
+   R objects, call back into R or signal errors. */
+typedef void (*R_gc_callback_t)(int phase, const R_gc_info_t *info, void *data);
+
+/* returns an id for R_gc_remove_callback(), or -1 if there are too many */
+int	R_gc_add_callback(R_gc_callback_t cb, void *data);
+/* returns 0 on success, -1 if id is not a registered callback */
+int	R_gc_remove_callback(int id);
+/* details of the last collection; returns 0 if there has been none */
+int	R_gc_last_info(R_gc_info_t *info);
+
 char*	R_alloc(size_t nelem, int eltsize);
 long double *R_allocLD(size_t nelem);
 char*	S_alloc(long nelem, int eltsize);
 char*	S_realloc(char * p, long new, long old, int size);
 
+/* Region mode for R_alloc (memory.c).  vmaxget_region() works like
+   vmaxget() but also switches R_alloc, R_allocLD, S_alloc and
+   S_realloc to a bump-pointer region until the matching vmaxset().
+   Region chunks are malloc'ed, start at 'initial' bytes (0 for the
+   default) and double in size as they fill; they are never seen by
+   the GC.  vmaxset() on the returned value resets the region in O(1),
+   keeping the largest chunk for reuse.  Scopes nest, and a longjmp
+   out of a scope is handled as for vmaxget(). */
+void*	vmaxget_region(size_t initial);
+
+/* Small vector classes (memory.c).  Vectors of up to 16 doubles of
+   data are allocated from R's small-vector node classes (gccls 1 to
+   R_SMALL_VEC_CLASSES: 1, 2, 4, 8 and 16 doubles), each with its own
+   free list on the class's heap pages.  Cells are now padded to a
+   whole number of cache lines so that no two small vectors share
+   one, and the functions below report the per-class counts and give
+   wholly free pages back. */
+#define R_SMALL_VEC_CLASSES 5
+
+typedef struct {
+    size_t cell_size;	/* bytes per cell: header + data, cache-line padded */
+    size_t in_use;	/* cells holding live or not yet collected vectors */
+    size_t nfree;	/* cells on the free list */
+    size_t hits;	/* allocations served from the free list */
+    size_t refills;	/* times the free list had to be refilled */
+} R_small_pool_stats_t;
+
+/* fills at most n entries, returns the number of size classes */
+int	R_SmallPoolStats(R_small_pool_stats_t *stats, int n);
+/* release wholly free small-vector pages back to the heap */
+void	R_SmallPoolTrim(void);
+
 #ifdef  __cplusplus
 }
 #endif
@@ -56,6 +56,20 @@ typedef enum {
     SA_SUICIDE
 } SA_TYPE;
 
+/* Heap sizing policies.  Under HP_ADAPTIVE the memory limit is
+   'heap_limit' if non-zero, otherwise that of the cgroup (v2
+   memory.max), otherwise physical memory.  The GC thresholds start
+   at vsize/nsize and are grown while the heap is well below the
+   limit, so collections are less frequent; near the limit R collects
+   the old generation early and returns free pages to the OS
+   (madvise, malloc_trim).  max_vsize/max_nsize still apply.  The
+   default is HP_STATIC; set R_HEAP_POLICY=adaptive in the environment
+   (read by R_SizeFromEnv) or HeapPolicy below to opt in. */
+typedef enum {
+    HP_STATIC,	/* = 0: thresholds grow only by the fixed GC rules */
+    HP_ADAPTIVE
+} HP_TYPE;
+
 typedef struct
 {
     Rboolean R_Quiet;
@@ -86,14 +100,30 @@ typedef struct
     UImode CharacterMode;
     blah7 WriteConsoleEx; /* used only if WriteConsole is NULL */
 #endif
+    /* R_STARTUP_VERSION >= 1 */
+    HP_TYPE HeapPolicy; /* default HP_STATIC */
+    size_t heap_limit;  /* bytes, 0 = detect */
 } structRstart;
 
 typedef structRstart *Rstart;
 
+/* Layout of structRstart: fields marked with a version exist only
+   from that version on.  The struct has no version field, since one
+   could not be read from a struct compiled against an older header.
+   Instead R_DefParamsEx() records the pair (Rp, version) inside R
+   (startup.c) and initialises the fields of that version.
+   R_DefParams(Rp) is R_DefParamsEx(Rp, 0).  R_SetParams(),
+   R_SizeFromEnv() and R_common_command_line() look up the recorded
+   version for Rp and neither read nor write newer fields; in
+   particular R_HEAP_POLICY, R_HEAP_LIMIT and the matching command
+   line options are ignored for a version 0 Rp. */
+#define R_STARTUP_VERSION 1
+
 void R_DefParams(Rstart Rp);
+void R_DefParamsEx(Rstart Rp, int version);
 void R_SetParams(Rstart Rp);
 void R_SetWin32(Rstart);
-void R_SizeFromEnv(Rstart Rp);
+void R_SizeFromEnv(Rstart Rp); /* R_HEAP_POLICY, R_HEAP_LIMIT from version 1 */
 void R_common_command_line(int * pac, char ** argv, Rstart Rp);
 
 void R_set_command_line_arguments(int argc, char **argv);
@@ -49,4 +49,95 @@ struct R_allocator {
     void *data;               /* custom data for the allocator implementation */
 };
 
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+/* Ready-made arena allocators (../../main/allocators.c).
+
+   Flags for R_MakeArenaAllocator(); they may be combined. */
+#define R_ARENA_HUGEPAGE   1  /* 2MB pages via madvise(MADV_HUGEPAGE) */
+#define R_ARENA_NUMA_BIND  2  /* pin pages to 'numa_node' via mbind() */
+#define R_ARENA_PER_THREAD 4  /* one arena per allocating thread */
+
+/** @brief Create an arena-backed allocator for use with allocVector3().
+ *
+ * Memory is obtained from the OS in chunks of at least \a chunk_size
+ * bytes (rounded up to 2MB when R_ARENA_HUGEPAGE is set) and carved
+ * into vector nodes.  Blocks larger than a chunk get a mapping of
+ * their own, which starts on a huge page boundary; the vector data
+ * itself begins after the node header and R's copy of the allocator,
+ * so DATAPTR() is not page aligned.
+ *
+ * Freed blocks go on per-size free lists and are reused by later
+ * allocations; a chunk whose blocks are all free is returned to the
+ * OS, as is a separately mapped large block when it is freed.
+ *
+ * Flags that the platform cannot honour (no transparent huge pages,
+ * no NUMA support) are silently ignored and the allocator falls back
+ * to plain anonymous mappings.
+ *
+ * @param flags A combination of the R_ARENA_* flags above.
+ *
+ * @param numa_node NUMA node to bind to when R_ARENA_NUMA_BIND is
+ *          set, or -1 for the node of the calling thread.  Ignored
+ *          otherwise.
+ *
+ * @param chunk_size Minimum size of an arena chunk in bytes, or 0
+ *          for the default (64MB).
+ *
+ * @return Pointer to the allocator, or NULL if it could not be
+ *         created.  The arena is reference counted: the caller holds
+ *         one reference, and every block handed out holds another
+ *         until its \c mem_free.
+ */
+R_allocator_t *R_MakeArenaAllocator(int flags, int numa_node, size_t chunk_size);
+
+/** @brief Drop the creator's reference to an arena allocator.
+ *
+ * No further allocations may be made from \a allocator .  The arena
+ * and its chunks are released when the last block allocated from it
+ * is freed, i.e. when the GC has collected every vector using it
+ * (at once if there are none).  It is therefore safe to call this
+ * while such vectors are still alive, including from a finalizer.
+ *
+ * @param allocator Pointer to the allocator to be released.
+ */
+void R_FreeArenaAllocator(R_allocator_t *allocator);
+
+/* File-backed allocator (../../main/allocators.c).
+
+   Flags for R_MakeFileAllocator(). */
+#define R_MMAP_SHARED   0  /* writes go to the file, visible to others */
+#define R_MMAP_PRIVATE  1  /* copy-on-write: writes stay in this process */
+#define R_MMAP_READONLY 2  /* map read-only; writes fault */
+#define R_MMAP_CREATE   4  /* create or extend the file as needed */
+
+/** @brief Create an allocator whose storage is a mapping of a file.
+ *
+ * Each call of \c mem_alloc maps \a path starting at \a offset.  The
+ * vector header is placed on an anonymous page immediately before
+ * the mapping, so the file holds nothing but the vector data and
+ * DATAPTR() points into the page cache.  \c mem_free unmaps both.
+ *
+ * Most code should use R_mmapVector() / R_openMmapVector() in
+ * Rinternals.h rather than calling this directly.
+ *
+ * @param path Name of the file to map (already expanded).
+ *
+ * @param offset Byte offset of the vector data within the file.
+ *          Must be a multiple of the page size.
+ *
+ * @param flags A combination of the R_MMAP_* flags above.
+ *
+ * @return Pointer to the allocator, or NULL if \a path could not be
+ *         opened.  The allocator is single-use: it serves exactly one
+ *         allocation and is released by its \c mem_free.
+ */
+R_allocator_t *R_MakeFileAllocator(const char *path, size_t offset, int flags);
+
+#ifdef  __cplusplus
+}
+#endif
+
 #endif /* R_EXT_RALLOCATORS_H_ */
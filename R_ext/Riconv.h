@@ -39,6 +39,18 @@ size_t Riconv (void * cd, const char **inbuf, size_t *inbytesleft,
 	       char  **outbuf, size_t *outbytesleft);
 int Riconv_close (void * cd);
 
+/* Bulk conversion, used by connections.  Handles from
+   Riconv_open_bulk() convert latin1 <-> UTF-8 with vectorized code.
+   When both encodings are ASCII supersets (UTF-8, latin1, other
+   ISO-8859 and Windows code pages, but not UTF-16/32 or EBCDIC) they
+   copy ASCII runs straight through; everything else goes to iconv
+   in 64KB blocks.  The arguments and return value of Riconv_bulk()
+   are as for Riconv(), including the handling of incomplete input. */
+void * Riconv_open_bulk (const char* tocode, const char* fromcode);
+size_t Riconv_bulk (void * cd, const char **inbuf, size_t *inbytesleft,
+		    char  **outbuf, size_t *outbytesleft);
+int Riconv_close_bulk (void * cd);
+
 #ifdef  __cplusplus
 }
 #endif
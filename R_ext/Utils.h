@@ -90,6 +90,15 @@ double R_strtod(const char *c, char **end);
 char *R_tmpnam(const char *prefix, const char *tempdir);
 char *R_tmpnam2(const char *prefix, const char *tempdir, const char *fileext);
 
+/* Bulk text scanning, also used for CHARSXP creation and nchar().
+   These use SSE4.2 or AVX2 code when the CPU has it (checked once at
+   startup) and portable scalar code otherwise; the results are the
+   same either way.  'n' is the number of bytes at 's'. */
+Rboolean R_strIsASCII(const char *s, size_t n);
+Rboolean R_utf8Valid(const char *s, size_t n);
+/* number of code points, counting each invalid byte as one */
+size_t	R_utf8Length(const char *s, size_t n);
+
 void R_CheckUserInterrupt(void);
 void R_CheckStack(void);
 void R_CheckStack2(size_t extra);
@@ -182,6 +182,21 @@ typedef enum {
 #define TYPE_BITS 5
 #define MAX_NUM_SEXPTYPE (1<<TYPE_BITS)
 
+/* Reference counting is used instead of the 'NAMED' mechanism unless
+   SWITCH_TO_NAMED is defined.  This uses the R-devel binary layout.
+   The two 'named' field bits are used for the REFCNT, so REFCNTMAX is
+   3; unlike NAMED, counts are decremented again when bindings,
+   promise values and closure arguments go away, so MAYBE_SHARED()
+   only reports objects that really are shared. */
+#if ! defined(SWITCH_TO_NAMED) && ! defined(SWITCH_TO_REFCNT)
+# define SWITCH_TO_REFCNT
+#endif
+
+#if defined(SWITCH_TO_REFCNT) && ! defined(COMPUTE_REFCNT_VALUES)
+# define COMPUTE_REFCNT_VALUES
+#endif
+#define REFCNTMAX (4 - 1)
+
 // ======================= USE_RINTERNALS section
 #ifdef USE_RINTERNALS
 /* This is intended for use only within R itself.
@@ -204,7 +219,7 @@ struct sxpinfo_struct {
     unsigned int mark  :  1;
     unsigned int debug :  1;
     unsigned int trace :  1;  /* functions and memory tracing */
-    unsigned int spare :  1;  /* currently unused */
+    unsigned int spare :  1;  /* RSTEP on closures; TRACKREFS (negated) on others */
     unsigned int gcgen :  1;  /* old generation number */
     unsigned int gccls :  3;  /* node class */
 }; /*		    Tot: 32 */
@@ -252,16 +267,6 @@ struct promsxp_struct {
    field. Under the generational collector these are followed by the
    fields used to maintain the collector's linked list structures. */
 
-/* Define SWITH_TO_REFCNT to use reference counting instead of the
-   'NAMED' mechanism. This uses the R-devel binary layout. The two
-   'named' field bits are used for the REFCNT, so REFCNTMAX is 3. */
-//#define SWITCH_TO_REFCNT
-
-#if defined(SWITCH_TO_REFCNT) && ! defined(COMPUTE_REFCNT_VALUES)
-# define COMPUTE_REFCNT_VALUES
-#endif
-#define REFCNTMAX (4 - 1)
-
 #define SEXPREC_HEADER \
     struct sxpinfo_struct sxpinfo; \
     struct SEXPREC *attrib; \
@@ -299,16 +304,17 @@ typedef union { VECTOR_SEXPREC s; double align; } SEXPREC_ALIGN;
 /* General Cons Cell Attributes */
 #define ATTRIB(x)	((x)->attrib)
 #define OBJECT(x)	((x)->sxpinfo.obj)
-#define MARK(x)		((x)->sxpinfo.mark)
+/* no MARK() macro: the mark may be in a page bitmap, see (MARK) */
 #define TYPEOF(x)	((x)->sxpinfo.type)
 #define NAMED(x)	((x)->sxpinfo.named)
 #define RTRACE(x)	((x)->sxpinfo.trace)
-#define LEVELS(x)	((x)->sxpinfo.gp)
+#define LEVELS(x)	((x)->sxpinfo.gp & ~VEC_UNSAVED_MASK(x))
 #define SET_OBJECT(x,v)	(((x)->sxpinfo.obj)=(v))
 #define SET_TYPEOF(x,v)	(((x)->sxpinfo.type)=(v))
 #define SET_NAMED(x,v)	(((x)->sxpinfo.named)=(v))
 #define SET_RTRACE(x,v)	(((x)->sxpinfo.trace)=(v))
-#define SETLEVELS(x,v)	(((x)->sxpinfo.gp)=((unsigned short)v))
+#define SETLEVELS(x,v)	(((x)->sxpinfo.gp)=(((unsigned short)(v) & ~VEC_UNSAVED_MASK(x)) | \
+				((x)->sxpinfo.gp & VEC_UNSAVED_MASK(x))))
 
 #if defined(COMPUTE_REFCNT_VALUES)
 # define REFCNT(x) ((x)->sxpinfo.named)
@@ -377,14 +383,72 @@ typedef union { VECTOR_SEXPREC s; double align; } SEXPREC_ALIGN;
 
 /* Under the generational allocator the data for vector nodes comes
    immediately after the node structure, so the data address is a
-   known offset from the node SEXP. */
-#define DATAPTR(x)	(((SEXPREC_ALIGN *) (x)) + 1)
-#define CHAR(x)		((const char *) DATAPTR(x))
+   known offset from the node SEXP.  Compact sequences (INTSXP or
+   REALSXP with COMPACT_SEQ_MASK set) instead hold their start and
+   step there, and get their data allocated by R_compact_seq_dataptr()
+   the first time a data pointer is asked for.  That data is malloc'ed
+   outside the GC heap and freed when the node is collected, so
+   DATAPTR() and INTEGER()/REAL() never run the GC.  Its size is
+   still added to R_VSize and checked against max_vsize, so it counts
+   towards the next collection and errors if the limit is exceeded.
+
+   On INTSXP and REALSXP, COMPACT_SEQ_MASK describes the
+   representation, not the value: for those types VEC_REPR_MASK()
+   (part of VEC_UNSAVED_MASK() below) keeps it out of LEVELS() and
+   SETLEVELS() leaves it alone, so
+   serialize.c, which saves and restores gp through them, neither
+   writes nor restores it.  Other types use gp bit 15 for their own
+   flags (active bindings, global frame environments), which LEVELS()
+   and SETLEVELS() pass through unchanged.  (The spare sxpinfo bit is
+   taken by TRACKREFS.) */
+#define COMPACT_SEQ_MASK ((unsigned short)(1<<15))
+#define VEC_REPR_MASK(x) \
+    ((TYPEOF(x) == INTSXP || TYPEOF(x) == REALSXP) ? COMPACT_SEQ_MASK : 0)
+#define IS_COMPACT_SEQ(x) ((x)->sxpinfo.gp & VEC_REPR_MASK(x))
+#define STDVEC_DATAPTR(x)	(((SEXPREC_ALIGN *) (x)) + 1)
+#define DATAPTR(x)	(IS_COMPACT_SEQ(x) ? R_compact_seq_dataptr(x) : \
+			 (void *) STDVEC_DATAPTR(x))
+#define CHAR(x)		((const char *) STDVEC_DATAPTR(x))
+
+/* Sortedness and NA metadata of atomic vectors.  The accessor macros
+   below have no side effects, so they neither read nor clear these
+   bits.  The explicit write paths clear them: SET_STRING_ELT() and the
+   other element and range setters, the *_SET_REGION functions, and
+   the exported LOGICAL(), INTEGER() etc. functions, which hand out a
+   writable pointer.  Code that writes in place through the macros
+   (R's own in-place arithmetic and subassignment, and packages using
+   USE_RINTERNALS) must call CLEAR_VEC_METADATA() first.  Both
+   SORTED_INCR_MASK and SORTED_DECR_MASK set records KNOWN_UNSORTED.
+
+   The bits are cached facts, not part of the value, so for atomic
+   vectors VEC_UNSAVED_MASK() keeps them, like COMPACT_SEQ_MASK, out
+   of LEVELS() and SETLEVELS(): they are not serialized, and a
+   loaded vector never claims to be sorted. */
+#define SORTED_NA_1ST_MASK ((unsigned short)(1<<11))
+#define SORTED_INCR_MASK   ((unsigned short)(1<<12))
+#define SORTED_DECR_MASK   ((unsigned short)(1<<13))
+#define NO_NA_MASK         ((unsigned short)(1<<14))
+#define VEC_METADATA_MASK \
+    (SORTED_NA_1ST_MASK | SORTED_INCR_MASK | SORTED_DECR_MASK | NO_NA_MASK)
+#define KNOWN_NO_NA(x)	((x)->sxpinfo.gp & NO_NA_MASK)
+#define CLEAR_VEC_METADATA(x) (((x)->sxpinfo.gp) &= ~VEC_METADATA_MASK)
+#define VEC_UNSAVED_MASK(x) \
+    (VEC_REPR_MASK(x) |							\
+     ((TYPEOF(x) == LGLSXP || TYPEOF(x) == INTSXP || TYPEOF(x) == REALSXP || \
+       TYPEOF(x) == CPLXSXP || TYPEOF(x) == STRSXP || TYPEOF(x) == RAWSXP) ? \
+      VEC_METADATA_MASK : 0))
+
 #define LOGICAL(x)	((int *) DATAPTR(x))
 #define INTEGER(x)	((int *) DATAPTR(x))
 #define RAW(x)		((Rbyte *) DATAPTR(x))
 #define COMPLEX(x)	((Rcomplex *) DATAPTR(x))
 #define REAL(x)		((double *) DATAPTR(x))
+#define DATAPTR_RO(x)	((const void *) DATAPTR(x))
+#define LOGICAL_RO(x)	((const int *) DATAPTR(x))
+#define INTEGER_RO(x)	((const int *) DATAPTR(x))
+#define RAW_RO(x)	((const Rbyte *) DATAPTR(x))
+#define COMPLEX_RO(x)	((const Rcomplex *) DATAPTR(x))
+#define REAL_RO(x)	((const double *) DATAPTR(x))
 #define STRING_ELT(x,i)	((SEXP *) DATAPTR(x))[i]
 #define VECTOR_ELT(x,i)	((SEXP *) DATAPTR(x))[i]
 #define STRING_PTR(x)	((SEXP *) DATAPTR(x))
@@ -536,7 +600,7 @@ Rboolean (Rf_isObject)(SEXP s);
 	    SET_NAMED(__x__, NAMED(__x__) + 1);		\
     } while (0)
 
-#if defined(COMPUTE_REFCNT_VALUES)
+#if defined(COMPUTE_REFCNT_VALUES) && defined(USE_RINTERNALS)
 # define SET_REFCNT(x,v) (REFCNT(x) = (v))
 # if defined(EXTRA_REFCNT_FIELDS)
 #  define SET_TRACKREFS(x,v) (TRACKREFS(x) = (v))
@@ -567,7 +631,9 @@ Rboolean (Rf_isObject)(SEXP s);
 #ifdef SWITCH_TO_REFCNT
 # define MAYBE_SHARED(x) (REFCNT(x) > 1)
 # define NO_REFERENCES(x) (REFCNT(x) == 0)
-# define MARK_NOT_MUTABLE(x) SET_REFCNT(x, REFCNTMAX)
+# ifdef USE_RINTERNALS
+#  define MARK_NOT_MUTABLE(x) SET_REFCNT(x, REFCNTMAX)
+# endif
 #else
 # define MAYBE_SHARED(x) (NAMED(x) > 1)
 # define NO_REFERENCES(x) (NAMED(x) == 0)
@@ -576,6 +642,13 @@ Rboolean (Rf_isObject)(SEXP s);
 #define MAYBE_REFERENCED(x) (! NO_REFERENCES(x))
 #define NOT_SHARED(x) (! MAYBE_SHARED(x))
 
+/** @brief Mark an object as shared, so that it is duplicated
+ * before any modification.
+ *
+ * @param x Pointer to an R value.
+ */
+void (MARK_NOT_MUTABLE)(SEXP x);
+
 /* Complex assignment support */
 /* temporary definition that will need to be refined to distinguish
    getter from setter calls */
@@ -605,6 +678,15 @@ SEXP (ATTRIB)(SEXP x);
  * @return true iff \a x has a class attribute.
  */
 int  (OBJECT)(SEXP x);
+
+/** @brief Get the GC mark of an object.
+ *
+ * @param x Pointer to an R value.
+ *
+ * @return The mark from the page bitmap if R_gc_mark_bitmap() is on,
+ *         otherwise from the object header.  Only meaningful during
+ *         a collection.
+ */
 int  (MARK)(SEXP x);
 
 /** @brief Get object's SEXPTYPE.
@@ -629,7 +711,9 @@ void (SET_TYPEOF)(SEXP x, int v);
 /** @brief Set object copying status.
  *
  * @param x Pointer to R value.  The function does nothing
- *          if \a x is R_NilValue.
+ *          if \a x is R_NilValue, or at all when reference counting
+ *          is in use (see SWITCH_TO_REFCNT); use MARK_NOT_MUTABLE()
+ *          to mark an object as shared.
  *
  * @param v Refer to 'R Internals' document.
  */
@@ -712,9 +796,16 @@ R_xlen_t  (XLENGTH)(SEXP x);
  */
 R_xlen_t  (XTRUELENGTH)(SEXP x);
 int  (IS_LONG_VEC)(SEXP x);
+/* gp bits as serialized: for atomic vectors the sortedness and NA
+   bits, and for INTSXP and REALSXP COMPACT_SEQ_MASK, are neither read
+   nor written; other types see all 16 bits */
 int  (LEVELS)(SEXP x);
 int  (SETLEVELS)(SEXP x, int v);
 
+/* The functions below return a writable pointer and so clear the
+   sortedness and NA metadata of \a x ; code that only reads should
+   use the *_RO() variants, *_ELT() or DATAPTR_RO() instead. */
+
 /**
  * @param x Pointer to a logical vector.
  *
@@ -751,6 +842,178 @@ double *(REAL)(SEXP x);
  */
 Rcomplex *(COMPLEX)(SEXP x);
 
+/* Read-only pointers: as above, but the metadata is kept */
+const int *(LOGICAL_RO)(SEXP x);
+const int *(INTEGER_RO)(SEXP x);
+const Rbyte *(RAW_RO)(SEXP x);
+const double *(REAL_RO)(SEXP x);
+const Rcomplex *(COMPLEX_RO)(SEXP x);
+
+/* Element access without forcing the data of compact sequences */
+
+/**
+ * @param x Pointer to an integer vector (possibly a compact sequence).
+ *
+ * @param i Index of the required element.  There is no bounds
+ *          checking.
+ *
+ * @return The \a i 'th element of \a x .
+ */
+int (INTEGER_ELT)(SEXP x, R_xlen_t i);
+
+/**
+ * @param x Pointer to a numeric vector (possibly a compact sequence).
+ *
+ * @param i Index of the required element.  There is no bounds
+ *          checking.
+ *
+ * @return The \a i 'th element of \a x .
+ */
+double (REAL_ELT)(SEXP x, R_xlen_t i);
+int (LOGICAL_ELT)(SEXP x, R_xlen_t i);
+Rbyte (RAW_ELT)(SEXP x, R_xlen_t i);
+Rcomplex (COMPLEX_ELT)(SEXP x, R_xlen_t i);
+
+/**
+ * @param x Pointer to a vector object.
+ *
+ * @return Pointer to the first element of \a x , or NULL if \a x is
+ *         a compact sequence whose data has not been allocated.
+ *         Unlike DATAPTR() this never allocates.
+ */
+void *(DATAPTR_OR_NULL)(SEXP x);
+
+/**
+ * @param x Pointer to a vector object.
+ *
+ * @return Read-only pointer to the first element of \a x .  Unlike
+ *         INTEGER(), REAL() etc. this leaves the sortedness and NA
+ *         metadata of \a x in place.
+ */
+const void *(DATAPTR_RO)(SEXP x);
+
+/* Region access: copy elements i to i + n - 1 to or from a caller
+   buffer without exposing or allocating the data of \a sx , so
+   compact sequences and the like can be processed block by block
+   (see ITERATE_BY_REGION in R_ext/Itermacros.h).  The getters return
+   the number of elements copied, which is less than \a n only at
+   the end of the vector.  The setters clear the sortedness and NA
+   metadata of \a sx , and give a compact sequence ordinary data. */
+R_xlen_t INTEGER_GET_REGION(SEXP sx, R_xlen_t i, R_xlen_t n, int *buf);
+R_xlen_t REAL_GET_REGION(SEXP sx, R_xlen_t i, R_xlen_t n, double *buf);
+R_xlen_t LOGICAL_GET_REGION(SEXP sx, R_xlen_t i, R_xlen_t n, int *buf);
+R_xlen_t RAW_GET_REGION(SEXP sx, R_xlen_t i, R_xlen_t n, Rbyte *buf);
+R_xlen_t COMPLEX_GET_REGION(SEXP sx, R_xlen_t i, R_xlen_t n, Rcomplex *buf);
+void INTEGER_SET_REGION(SEXP sx, R_xlen_t i, R_xlen_t n, const int *buf);
+void REAL_SET_REGION(SEXP sx, R_xlen_t i, R_xlen_t n, const double *buf);
+void LOGICAL_SET_REGION(SEXP sx, R_xlen_t i, R_xlen_t n, const int *buf);
+void RAW_SET_REGION(SEXP sx, R_xlen_t i, R_xlen_t n, const Rbyte *buf);
+void COMPLEX_SET_REGION(SEXP sx, R_xlen_t i, R_xlen_t n, const Rcomplex *buf);
+
+/* Sortedness and NA metadata.  The *_IS_SORTED functions return one
+   of the values below, the *_NO_NA functions TRUE only if \a x is
+   known to contain no NA (or NaN).  Both are set by sorting and
+   ordering, by the scalar and sequence constructors and by
+   R_set_sorted() / R_set_no_na(), and are cleared by any write.
+   Sortedness is non-strict: ties are allowed in a sorted vector.
+
+   For character vectors sortedness is recorded only in C-locale
+   (byte) order, as produced by sorting in the C locale or with
+   method = "radix", so Sys.setlocale() cannot make it stale.  Code
+   comparing strings with Scollate() in another locale must not use
+   STRING_IS_SORTED(). */
+enum {
+    SORTED_DECR_NA_1ST = -2,
+    SORTED_DECR = -1,
+    UNKNOWN_SORTEDNESS = INT_MIN,
+    SORTED_INCR = 1,
+    SORTED_INCR_NA_1ST = 2,
+    KNOWN_UNSORTED = 0
+};
+#define KNOWN_SORTED(sorted) ((sorted) == SORTED_DECR ||		\
+			      (sorted) == SORTED_INCR ||		\
+			      (sorted) == SORTED_DECR_NA_1ST ||	\
+			      (sorted) == SORTED_INCR_NA_1ST)
+
+int INTEGER_IS_SORTED(SEXP x);
+int REAL_IS_SORTED(SEXP x);
+int STRING_IS_SORTED(SEXP x);
+int LOGICAL_NO_NA(SEXP x);
+int INTEGER_NO_NA(SEXP x);
+int REAL_NO_NA(SEXP x);
+int STRING_NO_NA(SEXP x);
+
+/** @brief Record the sortedness of a vector.
+ *
+ * @param x Pointer to an integer, numeric or character vector.
+ *
+ * @param sorted One of the sortedness values above.  The caller
+ *          vouches for it: it is not checked.
+ */
+void R_set_sorted(SEXP x, int sorted);
+
+/** @brief Record whether a vector is free of NA values.
+ *
+ * @param x Pointer to an atomic vector.
+ *
+ * @param no_na TRUE if \a x is known to contain no NA; not checked.
+ */
+void R_set_no_na(SEXP x, Rboolean no_na);
+
+/* Compact sequences */
+
+/** @brief Create the integer sequence n1:n2 without allocating it.
+ *
+ * The result is an INTSXP holding only its endpoints.  Elements are
+ * computed by INTEGER_ELT(); INTEGER() fills a malloc'ed copy of the
+ * data on first use.  That does not trigger the GC, but the bytes
+ * count towards R_VSize, and an error is signalled if they would
+ * exceed max_vsize or cannot be allocated.  sum(), min(), max(),
+ * order() and is.unsorted() answer directly from the endpoints.
+ *
+ * @param n1 First element.
+ *
+ * @param n2 Last element.  May be less than \a n1 .
+ *
+ * @return Pointer to the created sequence.  If the values do not all
+ *         fit in an int a REALSXP sequence is returned instead.
+ *
+ * @gc
+ */
+SEXP R_compact_intrange(R_xlen_t n1, R_xlen_t n2);
+
+/** @brief Create a numeric sequence without allocating it.
+ *
+ * @param start First element.
+ *
+ * @param step Difference between successive elements.
+ *
+ * @param n The length of the sequence.
+ *
+ * @return Pointer to a REALSXP whose \a i 'th element is
+ *         <tt>start + i * step</tt>.
+ *
+ * @gc
+ */
+SEXP R_compact_realseq(double start, double step, R_xlen_t n);
+
+/** @brief Query a compact sequence.
+ *
+ * @param x Pointer to an R value.
+ *
+ * @param start If not NULL, set to the first element of \a x .
+ *
+ * @param step If not NULL, set to the difference between
+ *          successive elements of \a x .
+ *
+ * @return TRUE iff \a x is a compact sequence; \a start and \a step
+ *         are only set in that case.
+ */
+Rboolean R_compact_seq_info(SEXP x, double *start, double *step);
+/* expands x into malloc'ed memory on first call, counted in R_VSize;
+   never runs the GC */
+void *R_compact_seq_dataptr(SEXP x);
+
 /**
  * @brief Examine element of a character vector.
  *
@@ -780,6 +1043,8 @@ SEXP (VECTOR_ELT)(SEXP x, R_xlen_t i);
  * @param i Index of the required element.  There is no bounds checking.
  *
  * @param v Pointer to CHARSXP representing the new value.
+ *
+ * Clears the sortedness and NA metadata of \a x .
  */
 void SET_STRING_ELT(SEXP x, R_xlen_t i, SEXP v);
 
@@ -794,6 +1059,74 @@ void SET_STRING_ELT(SEXP x, R_xlen_t i, SEXP v);
  * @return The new value \a v.
  */
 SEXP SET_VECTOR_ELT(SEXP x, R_xlen_t i, SEXP v);
+
+/* Range setters.  These check the generation of the target once and,
+   if it is older than any of the new values, age those values in a
+   single pass afterwards, instead of running the write barrier per
+   element as SET_STRING_ELT() and SET_VECTOR_ELT() do.  Reference
+   counts are maintained as by those functions: each new element's
+   REFCNT is incremented and each replaced element's decremented, so
+   MAYBE_SHARED() stays correct. */
+
+/** @brief Set a range of elements of a character vector.
+ *
+ * Clears the sortedness and NA metadata of \a x .
+ *
+ * @param x Pointer to a character vector.
+ *
+ * @param i 0-based index of the first element to set.
+ *
+ * @param n Number of elements to set.  Elements \a i to
+ *          <tt>i + n - 1</tt> must exist; there is no bounds checking.
+ *
+ * @param v Array of \a n CHARSXPs.  It may not overlap the data of
+ *          \a x .
+ */
+void SET_STRING_ELTS(SEXP x, R_xlen_t i, R_xlen_t n, const SEXP *v);
+
+/** @brief Set a range of elements of a character vector to one value.
+ *
+ * Clears the sortedness and NA metadata of \a x .
+ *
+ * @param x Pointer to a character vector.
+ *
+ * @param i 0-based index of the first element to set.
+ *
+ * @param n Number of elements to set.  Elements \a i to
+ *          <tt>i + n - 1</tt> must exist; there is no bounds checking.
+ *
+ * @param v Pointer to the CHARSXP to store in each element.
+ */
+void FILL_STRING_ELTS(SEXP x, R_xlen_t i, R_xlen_t n, SEXP v);
+
+/** @brief Set a range of elements of a list.
+ *
+ * @param x Pointer to a list (VECSXP or EXPRSXP).
+ *
+ * @param i 0-based index of the first element to set.
+ *
+ * @param n Number of elements to set.  Elements \a i to
+ *          <tt>i + n - 1</tt> must exist; there is no bounds checking.
+ *
+ * @param v Array of \a n pointers to R values.  It may not overlap
+ *          the data of \a x .
+ */
+void SET_VECTOR_ELTS(SEXP x, R_xlen_t i, R_xlen_t n, const SEXP *v);
+
+/** @brief Set a range of elements of a list to one value.
+ *
+ * @param x Pointer to a list (VECSXP or EXPRSXP).
+ *
+ * @param i 0-based index of the first element to set.
+ *
+ * @param n Number of elements to set.  Elements \a i to
+ *          <tt>i + n - 1</tt> must exist; there is no bounds checking.
+ *
+ * @param v Pointer to the R value to store in each element.  It is
+ *          not duplicated: its REFCNT is incremented once per element
+ *          set, so it is shared as soon as \a n > 1.
+ */
+void FILL_VECTOR_ELTS(SEXP x, R_xlen_t i, R_xlen_t n, SEXP v);
 SEXP *(STRING_PTR)(SEXP x);
 SEXP * NORET (VECTOR_PTR)(SEXP x);
 
@@ -1323,7 +1656,109 @@ SEXP Rf_allocS4Object(void);
  */
 SEXP Rf_allocSExp(SEXPTYPE t);
 SEXP Rf_allocVector3(SEXPTYPE type, R_xlen_t length, R_allocator_t* allocator);
+
+/* File-backed vectors: the R_MMAP_* flags are in R_ext/Rallocators.h.
+   Vectors mapped with R_MMAP_SHARED or R_MMAP_READONLY are returned
+   marked not mutable (MARK_NOT_MUTABLE()), so R code assigning into
+   them works on an ordinary copy rather than writing to the file, or
+   faulting on a read-only mapping.  Native code may still write into
+   a shared mapping through its data pointer, but never into a
+   read-only one. */
+
+/** @brief Create a vector whose data lives in a file.
+ *
+ * The file is created (or extended) to hold \a length elements and
+ * mapped; the vector contents are whatever the file holds, so a new
+ * file reads as zeros.
+ *
+ * @param type One of LGLSXP, INTSXP, REALSXP, CPLXSXP or RAWSXP.
+ *
+ * @param length The length of the vector to be created.
+ *
+ * @param path Name of the file.
+ *
+ * @param flags R_MMAP_SHARED or R_MMAP_PRIVATE.
+ *
+ * @return Pointer to the created vector, marked not mutable if
+ *         \a flags is R_MMAP_SHARED.
+ *
+ * @throws if \a type is not an atomic non-string type or the file
+ *         cannot be created or mapped.
+ *
+ * @gc
+ */
+SEXP R_mmapVector(SEXPTYPE type, R_xlen_t length, const char *path, int flags);
+
+/** @brief Map an existing file as a vector.
+ *
+ * The length is the file size divided by the element size; no data
+ * is read until it is touched.  Several processes opening the same
+ * file with R_MMAP_SHARED or R_MMAP_READONLY share one physical copy.
+ *
+ * @param type One of LGLSXP, INTSXP, REALSXP, CPLXSXP or RAWSXP.
+ *
+ * @param path Name of the file.
+ *
+ * @param flags A combination of R_MMAP_SHARED, R_MMAP_PRIVATE and
+ *          R_MMAP_READONLY.
+ *
+ * @return Pointer to the mapped vector, marked not mutable unless
+ *         \a flags is R_MMAP_PRIVATE alone.
+ *
+ * @throws if the file cannot be opened or its size is not a multiple
+ *         of the element size.
+ *
+ * @gc
+ */
+SEXP R_openMmapVector(SEXPTYPE type, const char *path, int flags);
+
+/** @brief Flush a file-backed vector to disk.
+ *
+ * @param x Pointer to a vector created by R_mmapVector() or
+ *          R_openMmapVector() with R_MMAP_SHARED.
+ *
+ * @param async If TRUE schedule the write-back (MS_ASYNC) and return
+ *          at once, otherwise wait for it (MS_SYNC).
+ *
+ * @return 0 on success (and at once, doing nothing, if \a x is a
+ *         private or read-only mapping), otherwise the \c errno
+ *         value from msync().  If \a x is not a file-backed vector
+ *         the result is EINVAL.
+ */
+int R_syncMmapVector(SEXP x, Rboolean async);
+
+/**
+ * @param x Pointer to an R value.
+ *
+ * @return TRUE iff \a x is a vector whose data is a file mapping.
+ */
+Rboolean R_isMmapVector(SEXP x);
+
+/* Hashing in unique.c: duplicated(), anyDuplicated() and match() may
+   use several threads (R_ext/MathThreads.h) on long inputs, but
+   their results do not depend on the number of threads used. */
+
+/** @brief Find the first duplicated element.
+ *
+ * @param x Pointer to a vector.
+ *
+ * @param from_last If TRUE, scan from the end.
+ *
+ * @return 1-based index of the first element of \a x that equals an
+ *         earlier one (a later one if \a from_last ), or 0 if there
+ *         is none.  Integer vectors known to be sorted, and
+ *         numeric ones known to be sorted and free of NA and NaN,
+ *         are scanned for equal neighbours without hashing.  Other
+ *         vectors, including sorted ones that may hold NA and NaN
+ *         (which sort as ties in input order), are hashed.
+ */
 R_xlen_t Rf_any_duplicated(SEXP x, Rboolean from_last);
+
+/** @brief As Rf_any_duplicated(), ignoring the values in \a incomp .
+ *
+ * @param incomp Vector of values that are never counted as
+ *          duplicates, or a length-one FALSE.
+ */
 R_xlen_t Rf_any_duplicated3(SEXP x, SEXP incomp, Rboolean from_last);
 SEXP Rf_applyClosure(SEXP call, SEXP op, SEXP arglist, SEXP rho, SEXP suppliedvars);
 SEXP Rf_arraySubscript(int dim, SEXP s, SEXP dims, SEXP (*)(SEXP,SEXP dng),
@@ -1370,10 +1805,66 @@ void Rf_defineVar(SEXP symbol, SEXP value, SEXP rho);
 SEXP Rf_dimgets(SEXP vec, SEXP val);
 SEXP Rf_dimnamesgets(SEXP vec, SEXP val);
 SEXP Rf_DropDims(SEXP x);
+
+/* Page-sharing duplication (duplicate.c, memory.c).  The data of
+   logical, integer, numeric, complex and raw vectors of at least
+   R_cow_threshold() bytes is kept in an anonymous memory-backed file
+   (memfd), mapped shared into the vector that created it.
+
+   Pages are shared only when the file holds exactly the source's
+   data, which is when the source is either
+   - that creating vector, still mapped shared, or
+   - a private mapping that has been not mutable (MAYBE_SHARED() or
+     MARK_NOT_MUTABLE()) since it was mapped, so it has no private
+     pages of its own.
+   The copy is then mapped from the file copy-on-write, and a shared
+   source is remapped copy-on-write too so that neither side's later
+   writes reach the other.  Pages are copied only when written.
+
+   Everything else is copied eagerly.  This covers copies made by
+   page sharing, which are handed out mutable and may have private
+   pages.  It also covers all file-backed vectors (R_mmapVector()),
+   whose file other processes may write.  Before mcfork() creates a
+   child, shared memfd mappings are remapped copy-on-write in the
+   parent, so the parent's later writes do not reach the child. */
+
+/** @brief Duplicate an object.
+ *
+ * Atomic vectors at or above R_cow_threshold() that qualify (see
+ * above) share their pages with \a s until written, so this is
+ * O(pages) rather than O(bytes).
+ *
+ * @param s Pointer to the object to be duplicated.
+ *
+ * @return Pointer to a deep copy of \a s .
+ *
+ * @gc
+ */
 SEXP Rf_duplicate(SEXP s);
 SEXP Rf_shallow_duplicate(SEXP s);
 SEXP Rf_lazy_duplicate(SEXP s);
+
+/** @brief Set the size above which duplication shares pages.
+ *
+ * @param bytes New threshold in bytes, 0 to disable page sharing,
+ *          or -1 to leave it unchanged.  The default is 64MB.
+ *
+ * @return The previous threshold.
+ */
+R_xlen_t R_cow_threshold(R_xlen_t bytes);
 /* the next really should not be here and is also in Defn.h */
+
+/** @brief Flag duplicated elements.
+ *
+ * @param x Pointer to a vector.
+ *
+ * @param from_last If TRUE, an element counts as duplicated when it
+ *          equals a later one rather than an earlier one.
+ *
+ * @return Logical vector of the same length as \a x .
+ *
+ * @gc
+ */
 SEXP Rf_duplicated(SEXP x, Rboolean from_last);
 Rboolean R_envHasNoSpecialSymbols(SEXP env);
 
@@ -1472,13 +1963,109 @@ Rboolean Rf_isFree(SEXP val);
 Rboolean Rf_isOrdered(SEXP s);
 Rboolean Rf_isUnmodifiedSpecSym(SEXP sym, SEXP env);
 Rboolean Rf_isUnordered(SEXP s);
+
+/** @brief Is a vector not sorted in increasing order?
+ *
+ * Answers from the sortedness metadata of \a x when it is known, so
+ * this is O(1) on vectors produced by sorting or ordering.  That
+ * metadata does not exclude ties, so with \a strictly TRUE a vector
+ * recorded as SORTED_INCR is still scanned for them.
+ *
+ * @param x Pointer to an atomic vector.
+ *
+ * @param strictly If TRUE, ties count as unsorted.
+ *
+ * @return TRUE iff \a x is not sorted.
+ */
 Rboolean Rf_isUnsorted(SEXP x, Rboolean strictly);
 SEXP Rf_lengthgets(SEXP x, R_len_t len);
 SEXP Rf_xlengthgets(SEXP x, R_xlen_t len);
 SEXP R_lsInternal(SEXP env, Rboolean all);
 SEXP R_lsInternal3(SEXP env, Rboolean all, Rboolean sorted);
+
+/** @brief C version of R's  match(ix, itable, nomatch = nmatch)
+ *
+ * A hash table is built over \a itable and \a ix is looked up in it.
+ * To match many times against the same table, see R_MakeMatchIndex().
+ *
+ * @param itable Pointer to the vector to be matched against.
+ *
+ * @param ix Pointer to the vector of values to be matched.
+ *
+ * @param nmatch Value returned for elements with no match.
+ *
+ * @return Integer vector of 1-based positions in \a itable .
+ *
+ * @gc
+ */
 SEXP Rf_match(SEXP itable, SEXP ix, int nmatch);
 SEXP Rf_matchE(SEXP itable, SEXP ix, int nmatch, SEXP env);
+
+/* Prepared match indexes (unique.c) */
+
+/** @brief Build a reusable hash index over a table and mark the
+ *         table not mutable.
+ *
+ * Because of MARK_NOT_MUTABLE(), R code modifying \a table works on
+ * a copy.  Native code that nevertheless writes into an indexed
+ * table must then call R_InvalidateMatchIndexes() on it.
+ *
+ * Each table with indexes has a write generation, kept in a registry
+ * keyed by the table's address.  An index records the table's data
+ * pointer, length and generation when it is built; each lookup
+ * compares the three in O(1) and rebuilds the index if any differs.
+ * Any number of indexes may be made over the same table, and the
+ * registry entry goes when the last of them is finalized.
+ *
+ * @param table Pointer to an atomic vector.
+ *
+ * @return An external pointer holding the index and protecting
+ *         \a table .  The index is freed by its finalizer.
+ *
+ * @gc
+ */
+SEXP R_MakeMatchIndex(SEXP table);
+
+/** @brief match(x, table, nomatch) using a prepared index.
+ *
+ * @param index External pointer made by R_MakeMatchIndex().
+ *
+ * @param x Pointer to the vector of values to be looked up.
+ *
+ * @param nomatch Value returned for elements with no match.
+ *
+ * @return Integer vector of 1-based positions in the table.
+ *
+ * @gc
+ */
+SEXP R_MatchWithIndex(SEXP index, SEXP x, int nomatch);
+
+/** @brief x %in% table using a prepared index.
+ *
+ * @return Logical vector of the same length as \a x .
+ *
+ * @gc
+ */
+SEXP R_InWithIndex(SEXP index, SEXP x);
+
+/**
+ * @param index External pointer made by R_MakeMatchIndex().
+ *
+ * @return TRUE iff the table's data pointer, length and write
+ *         generation are those recorded when the index was last
+ *         built.
+ */
+Rboolean R_MatchIndexIsValid(SEXP index);
+
+/** @brief Declare that native code has written into a table.
+ *
+ * Bumps the write generation of \a table , so every index over it is
+ * rebuilt on its next lookup.  Does nothing if \a table has no
+ * index.  O(1).
+ *
+ * @param table Pointer to an atomic vector.
+ */
+void R_InvalidateMatchIndexes(SEXP table);
 SEXP Rf_namesgets(SEXP vec, SEXP val);
 
 /** @brief Get a pointer to a CHARSXP object.
@@ -1519,6 +2106,9 @@ int Rf_nrows(SEXP s);
 SEXP Rf_nthcdr(SEXP s, int n);
 
 // ../main/character.c :
+/* Bytes is O(1); Chars of ASCII or UTF-8 strings uses the vectorized
+   R_utf8Length() (R_ext/Utils.h); Width needs a per-character lookup
+   except for ASCII strings. */
 typedef enum {Bytes, Chars, Width} nchar_type;
 int R_nchar(SEXP string, nchar_type type_,
 	    Rboolean allowNA, Rboolean keepNA, const char* msg_name);
@@ -1566,7 +2156,34 @@ SEXP Rf_stringSuffix(SEXP string, int fromIndex);
 SEXPTYPE Rf_str2type(const char * s);
 Rboolean Rf_StringBlank(SEXP x);
 SEXP Rf_substitute(SEXP lang,SEXP rho);
+
+/* Translations of non-ASCII CHARSXPs are cached (sysutils.c) in a
+   weak table keyed by the CHARSXP and target encoding, so each
+   string is converted at most once per locale.  For ASCII strings
+   the text of the CHARSXP itself is returned and no work is done.
+   A cached result stays valid for as long as the CHARSXP does, which
+   covers the R_alloc() lifetime earlier code relies on; this holds
+   across locale changes too, since R_FlushTranslationCache() only
+   marks entries stale and they are freed with their CHARSXP. */
+
+/** @brief Convert contents of a CHARSXP to the native encoding.
+ *
+ * @param x Pointer to a CHARSXP.
+ *
+ * @return The text of \a x in the native encoding, with
+ *         unrepresentable characters escaped as <U+xxxx>.
+ *
+ * @note The result is cached with \a x (see above); it must not be
+ * modified.
+ */
 const char * Rf_translateChar(SEXP x);
+
+/** @brief As Rf_translateChar(), but bytes-encoded strings are
+ * returned as they are rather than signalling an error.
+ *
+ * @note The result is cached with \a x (see above); it must not be
+ * modified.
+ */
 const char * Rf_translateChar0(SEXP x);
 
 /** @brief Convert contents of a CHARSXP to UTF8.
@@ -1575,12 +2192,28 @@ const char * Rf_translateChar0(SEXP x);
  *
  * @return The text of \a x rendered in UTF8 encoding.
  *
- * @note The result is held in memory allocated using R_alloc().
- * The calling code must arrange for this memory to be released in
- * due course.
+ * @note The result is cached with \a x (see above); it must not be
+ * modified.
  */
 const char * Rf_translateCharUTF8(SEXP x);
 
+/**
+ * @param x Pointer to a CHARSXP.
+ *
+ * @return TRUE iff \a x contains only ASCII characters, in which case
+ *         every translation of it is CHAR(x) itself.
+ */
+Rboolean R_charIsASCII(SEXP x);
+
+/** @brief Invalidate all cached translations.
+ *
+ * Called when the locale changes; packages should not need it.
+ * Entries are marked stale, so the next translation of a CHARSXP is
+ * recomputed, but their text is kept until the CHARSXP is collected:
+ * pointers obtained before the locale change remain readable.
+ */
+void R_FlushTranslationCache(void);
+
 /** @brief Name of type within R.
  *
  * Translate a SEXPTYPE to the name by which it is known within R.
@@ -1719,6 +2352,99 @@ SEXP Rf_mkCharCE(const char * name, cetype_t enc);
  * @return Pointer to the created string.
  */
 SEXP Rf_mkCharLenCE(const char * name, int len, cetype_t enc);
+
+/* Concurrent string creation (envir.c).  The CHARSXP cache is
+   split into shards by hash, each guarded by its own lock, so
+   CHARSXPs can be created from several threads at once.  Only
+   R_mkCharLenCE_mt() may be called from threads other than the main
+   one, and only between R_BeginConcurrentMkChar() and
+   R_EndConcurrentMkChar() on the main thread.  While that window is
+   open the main thread may store results with SET_STRING_ELT() but
+   must not otherwise allocate, as garbage collection is held off. */
+
+/** @brief Open a window for concurrent CHARSXP creation.
+ *
+ * Must be called on the main thread.  Windows do not nest.
+ */
+void R_BeginConcurrentMkChar(void);
+
+/** @brief Close the window opened by R_BeginConcurrentMkChar().
+ *
+ * Must be called on the main thread once all workers are done.
+ * CHARSXPs made in the window that have not been stored in a
+ * reachable object may be collected after this returns.
+ */
+void R_EndConcurrentMkChar(void);
+
+/** @brief Thread-safe version of Rf_mkCharLenCE().
+ *
+ * @param name The text of the string, possibly including embedded
+ *          null characters.
+ *
+ * @param len The length of the string pointed to by \a name .
+ *
+ * @param enc As for Rf_mkCharLenCE().
+ *
+ * @return Pointer to the (possibly preexisting) CHARSXP, or NULL if
+ *         the string is invalid or memory is exhausted.  This
+ *         function never signals an R error, as it may be running on
+ *         a thread that cannot longjmp to the R top level.
+ */
+SEXP R_mkCharLenCE_mt(const char *name, int len, cetype_t enc);
+
+/* Bulk string creation (envir.c) */
+typedef struct {
+    const char *data;	/* the text; NULL for NA_STRING */
+    int len;		/* bytes at 'data', excluding any terminator */
+    cetype_t enc;	/* as for Rf_mkCharLenCE() */
+} R_strview_t;
+
+/** @brief Create a character vector from an array of strings.
+ *
+ * Equivalent to allocating a STRSXP and calling
+ * SET_STRING_ELT(x, i, Rf_mkCharLenCE(...)) for each element, but
+ * all strings are hashed in one pass before the cache is probed and
+ * the cache is grown at most once.  Creating the CHARSXPs may run
+ * the GC, which can age the partly filled result, so as in
+ * R_setStringVector() the write barrier is run once per range of
+ * stored elements rather than skipped.
+ *
+ * @param strs Array of \a n string descriptions.
+ *
+ * @param n Number of strings.
+ *
+ * @return Pointer to the created character vector.
+ *
+ * @throws if a string is invalid in its encoding or contains an
+ *         embedded nul.
+ *
+ * @gc
+ */
+SEXP R_mkStringVector(const R_strview_t *strs, R_xlen_t n);
+
+/** @brief Set a range of elements of a character vector from an
+ * array of strings.
+ *
+ * As R_mkStringVector(), but stores into elements \a offset to
+ * <tt>offset + n - 1</tt> of the existing vector \a x .  Like
+ * SET_STRING_ELTS(), it runs the write barrier once for the whole
+ * range rather than once per element, and clears the sortedness and
+ * NA metadata of \a x .
+ *
+ * @param x Pointer to a character vector.
+ *
+ * @param offset 0-based index of the first element to set.
+ *
+ * @param strs Array of \a n string descriptions.
+ *
+ * @param n Number of strings.
+ *
+ * @throws as R_mkStringVector().  Elements before the failing one
+ *         have been set.
+ *
+ * @gc
+ */
+void R_setStringVector(SEXP x, R_xlen_t offset, const R_strview_t *strs, R_xlen_t n);
 const char *Rf_reEnc(const char *x, cetype_t ce_in, cetype_t ce_out, int subst);
 
 				/* return(.) NOT reached : for -Wall */
@@ -1958,10 +2684,16 @@ int R_check_class_etc      (SEXP x, const char **valid);
 
 /* preserve objects across GCs */
 
+/* The precious objects are kept in a hashed multiset (memory.c)
+   keyed by address, so preserving and releasing take constant
+   expected time however many objects are preserved, and the GC
+   scans the set as one root array. */
+
 /** @brief Protect object against garbage collection.
  *
  * This is intended for long-term protection, for which PROTECT()
- * etc. would be inappropriate.
+ * etc. would be inappropriate.  An object preserved several times
+ * stays protected until it has been released as many times.
  *
  * @param object Pointer to the object to be preserved.  It is
  *          permissible for this to be R_NilValue.
@@ -1978,6 +2710,80 @@ void R_PreserveObject(SEXP object);
  */
 void R_ReleaseObject(SEXP object);
 
+/* Private precious sets, for packages that preserve many objects and
+   want to drop them all at once (e.g. on unload). */
+
+/** @brief Create a precious multiset.
+ *
+ * @param initialSize Expected number of objects, or 0 for the default.
+ *
+ * @return The set.  It must be protected (normally with
+ *         R_PreserveObject()) to keep its members alive.
+ *
+ * @gc
+ */
+SEXP R_NewPreciousMSet(int initialSize);
+
+/** @brief Add an object to a precious multiset.
+ *
+ * @gc
+ */
+void R_PreserveInMSet(SEXP x, SEXP mset);
+
+/** @brief Remove one occurrence of an object from a precious multiset.
+ *
+ * Has no effect if \a x is not in \a mset .
+ */
+void R_ReleaseFromMSet(SEXP x, SEXP mset);
+
+/** @brief Remove all objects from a precious multiset.
+ *
+ * @param keepSize If non-zero, the set keeps at most this many slots
+ *          of storage for reuse.
+ */
+void R_ReleaseMSet(SEXP mset, int keepSize);
+
+/* Allocation sampling (memprof.c) */
+
+/** @brief Start sampling allocations.
+ *
+ * Allocations made by Rf_allocVector(), Rf_allocVector3(), Rf_cons(),
+ * Rf_mkCharLenCE() and R_alloc() are sampled on average once every
+ * \a interval bytes (the gaps are exponentially distributed, so small
+ * allocations are not systematically missed).  Each sample records
+ * the SEXPTYPE, the size in bytes, up to \a max_depth calls from the
+ * context stack and the native return address of the allocating
+ * call.  Calling this while sampling is active changes the settings
+ * and keeps the samples taken so far.
+ *
+ * @param interval Mean number of bytes between samples; 0 samples
+ *          every allocation.
+ *
+ * @param max_depth Maximum number of R calls recorded per sample.
+ */
+void R_MemSampleStart(size_t interval, int max_depth);
+
+/** @brief Stop sampling allocations.  Samples taken are kept. */
+void R_MemSampleStop(void);
+
+/** @brief Discard all samples taken so far. */
+void R_MemSampleReset(void);
+
+/** @brief Write the samples as a pprof profile.
+ *
+ * The file is a gzipped \c profile.proto with sample types
+ * \c alloc_objects/count and \c alloc_space/bytes, scaled to estimate
+ * the unsampled totals.  Each sample's stack lists the native return
+ * address followed by the R calls, innermost first, with srcref
+ * file and line where available; the SEXPTYPE is attached as the
+ * label \c type.
+ *
+ * @param path Name of the file to write.
+ *
+ * @return 0 on success, otherwise an \c errno value.
+ */
+int R_MemSampleWritePprof(const char *path);
+
 /* Shutdown actions */
 void R_dot_Last(void);		/* in main.c */
 void R_RunExitFinalizers(void);	/* in memory.c */
@@ -2002,12 +2808,85 @@ Rboolean R_compute_identical(SEXP x, SEXP y, int flags);
 
 SEXP R_body_no_src(SEXP x); // body(x) without "srcref" etc, ../main/utils.c
 
-/* C version of R's  indx <- order(..., na.last, decreasing) :
-   e.g.  arglist = Rf_lang2(x,y)  or  Rf_lang3(x,y,z) */
+/** @brief C version of R's  indx <- order(..., na.last, decreasing)
+ *
+ * Logical, integer, numeric and character keys are ordered by a
+ * stable LSD radix sort (radixsort.c) using up to
+ * R_num_math_threads threads: doubles are mapped to unsigned keys
+ * by flipping the sign bit of non-negative values and all bits of
+ * negative ones, after -0 is mapped to 0 and every NA and NaN to a
+ * single key, and strings are first grouped by
+ * CHARSXP pointer, then the distinct strings are sorted with
+ * Scollate() and ranked.  Other key types fall back to the
+ * comparison sort.  Ties keep their original order.
+ *
+ * @param indx Array of length \a n to receive the 0-based ordering.
+ *
+ * @param n The length of every key.
+ *
+ * @param arglist Pairlist of the keys, e.g. Rf_lang2(x,y) or
+ *          Rf_lang3(x,y,z).
+ *
+ * @param nalast If TRUE, NA and NaN sort last, otherwise first.  As
+ *          before, NA and NaN are ties and keep their input order.
+ *
+ * @param decreasing If TRUE, all keys are ordered decreasingly; NA
+ *          placement is not affected.
+ */
 void R_orderVector (int *indx, int n, SEXP arglist, Rboolean nalast, Rboolean decreasing);
-// C version of R's  indx <- order(x, na.last, decreasing) :
+
+/** @brief C version of R's  indx <- order(x, na.last, decreasing)
+ *
+ * As R_orderVector() for the single key \a x .  If \a x is known
+ * to be sorted (see INTEGER_IS_SORTED() etc.) no sort is done; for a
+ * character \a x that applies only when the collation locale is C.
+ */
 void R_orderVector1(int *indx, int n, SEXP x,       Rboolean nalast, Rboolean decreasing);
 
+/* Long-vector variants of the above and of the sorts in R_ext/Utils.h
+   (sort.c, qsort.c).  Arguments and conventions are as for the int
+   versions (so R_xqsort_I() still takes 1-based i and j), but lengths
+   and indices are R_xlen_t.  Full sorts and orderings of more than
+   2^20 elements are split across R_num_math_threads threads (see
+   R_ext/MathThreads.h); the partial sorts are single-threaded. */
+void R_xisort(int *x, R_xlen_t n);
+void R_xrsort(double *x, R_xlen_t n);
+void R_xcsort(Rcomplex *x, R_xlen_t n);
+void xrsort_with_index(double *x, R_xlen_t *indx, R_xlen_t n);
+void Rf_xrevsort(double *a, R_xlen_t *ib, R_xlen_t n);
+void Rf_xiPsort(int *x, R_xlen_t n, R_xlen_t k);
+void Rf_xrPsort(double *x, R_xlen_t n, R_xlen_t k);
+void Rf_xcPsort(Rcomplex *x, R_xlen_t n, R_xlen_t k);
+void R_xqsort_I(double *v, R_xlen_t *II, R_xlen_t i, R_xlen_t j);
+void R_xqsort_int_I(int *iv, R_xlen_t *II, R_xlen_t i, R_xlen_t j);
+void R_xorderVector (R_xlen_t *indx, R_xlen_t n, SEXP arglist, Rboolean nalast, Rboolean decreasing);
+void R_xorderVector1(R_xlen_t *indx, R_xlen_t n, SEXP x,       Rboolean nalast, Rboolean decreasing);
+
+/** @brief Order by several keys with a direction for each.
+ *
+ * Uses the radix engine of R_orderVector() without needing the keys
+ * in a pairlist.
+ *
+ * @param indx Array of length \a n to receive the 0-based ordering.
+ *
+ * @param n The length of every key.
+ *
+ * @param keys Array of \a nkeys vectors, most significant first.
+ *
+ * @param nkeys Number of keys.
+ *
+ * @param nalast As for R_orderVector().
+ *
+ * @param decreasing Array of \a nkeys flags, or NULL for all
+ *          increasing.
+ */
+void R_xorderVectorN(R_xlen_t *indx, R_xlen_t n, const SEXP *keys, int nkeys,
+		     Rboolean nalast, const Rboolean *decreasing);
+
+/* Sort an atomic vector in place (sort.c), like R_rsort() etc. but
+   recording the result with R_set_sorted() and R_set_no_na() */
+void Rf_sortVector(SEXP s, Rboolean decreasing);
+
 #ifndef R_NO_REMAP
 #define acopy_string		Rf_acopy_string
 #define addMissingVarsToNewEnv	Rf_addMissingVarsToNewEnv
@@ -2163,6 +3042,7 @@ void R_orderVector1(int *indx, int n, SEXP x,       Rboolean nalast, Rboolean de
 #define setSVector		Rf_setSVector
 #define setVar			Rf_setVar
 #define shallow_duplicate	Rf_shallow_duplicate
+#define sortVector		Rf_sortVector
 #define str2type		Rf_str2type
 #define stringSuffix		Rf_stringSuffix
 #define stringPositionTr	Rf_stringPositionTr
@@ -2181,8 +3061,12 @@ void R_orderVector1(int *indx, int n, SEXP x,       Rboolean nalast, Rboolean de
 #define VectorToPairList	Rf_VectorToPairList
 #define warningcall		Rf_warningcall
 #define warningcall_immediate	Rf_warningcall_immediate
+#define xcPsort			Rf_xcPsort
+#define xiPsort			Rf_xiPsort
 #define xlength(x)		Rf_xlength(x)
 #define xlengthgets		Rf_xlengthgets
+#define xrevsort		Rf_xrevsort
+#define xrPsort			Rf_xrPsort
 
 #endif
 
@@ -2202,7 +3086,9 @@ void R_orderVector1(int *indx, int n, SEXP x,       Rboolean nalast, Rboolean de
  *
  *  Allocate a vector object.  This ensures only validity of
  *  SEXPTYPE values representing lists (as the elements must be
- *  initialized).
+ *  initialized).  Short atomic vectors, including those made by
+ *  Rf_ScalarReal() and friends, are taken from the small vector
+ *  classes (see R_SmallPoolStats() in R_ext/Memory.h).
  *
  * @param stype The type of vector required.
  *